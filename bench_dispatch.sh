@@ -0,0 +1,83 @@
+#!/bin/sh
+#
+# bench_dispatch.sh
+#
+#   Runs every dispatch policy of the elevator simulation over the
+#   same workloads, in virtual time, and reports for each the ticks to
+#   finish, the mean and 99th percentile wait per trip, and the wall
+#   clock time.
+#
+#   Threads within a tick run in no fixed order, so the same policy on
+#   the same people can do quite differently from one run to the next.
+#   Each policy and workload is run several times, and the table gives
+#   the average of each figure over the runs, with the standard
+#   deviation of the waits.
+#
+#   The workloads are the .eld files here and some generated by
+#   people.py from fixed seeds, so every policy sees the same people.
+#
+#   usage: bench_dispatch.sh [-e elevators] [-p people] [-n seeds]
+#                            [-r runs]
+#
+
+elevators=4
+people=500
+seeds=3
+runs=5
+while getopts "e:p:n:r:" opt; do
+  case $opt in
+    e) elevators=$OPTARG ;;
+    p) people=$OPTARG ;;
+    n) seeds=$OPTARG ;;
+    r) runs=$OPTARG ;;
+    *) echo "usage: $0 [-e elevators] [-p people] [-n seeds] [-r runs]" >&2
+       exit 1 ;;
+  esac
+done
+
+dir=`mktemp -d` || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+# Generate the seeded workloads
+workloads=`ls *.eld`
+seed=1
+while [ $seed -le $seeds ]; do
+  ${PYTHON:-python} people.py -s $seed -p $people -t 5 -d 100 \
+    > "$dir/seed$seed.eld" || exit 1
+  workloads="$workloads $dir/seed$seed.eld"
+  seed=`expr $seed + 1`
+done
+
+# The policies elevators knows about
+policies=`./elevators -h 2>&1 | sed -n 's/.*dispatches by policy://p'`
+
+echo "$elevators elevators, $people people in each generated workload," \
+  "$runs runs of each"
+printf "%-12s %-14s %8s %8s %6s %8s %6s %8s\n" \
+  policy workload ticks mean "+-" p99 "+-" seconds
+for w in $workloads; do
+  for d in $policies; do
+    : > "$dir/out"
+    run=1
+    while [ $run -le $runs ]; do
+      start=`date +%s.%N`
+      ./elevators -s 0 -p -e $elevators -d $d < $w > "$dir/run" 2>/dev/null
+      end=`date +%s.%N`
+      echo "Seconds: $start $end" >> "$dir/run"
+      cat "$dir/run" >> "$dir/out"
+      run=`expr $run + 1`
+    done
+    awk -v d=$d -v w=`basename $w .eld` '
+      function sd(sum, sq, n,   v) {
+        v = n > 1 ? (sq - sum*sum/n) / (n - 1) : 0
+        return v > 0 ? sqrt(v) : 0
+      }
+      /^Finished in/ { ticks += $3 }
+      /^Average wait/ { mean += $NF; mean2 += $NF*$NF; n++ }
+      /^99th percentile/ { p99 += $NF; p992 += $NF*$NF }
+      /^Seconds:/ { secs += $3 - $2 }
+      END { printf "%-12s %-14s %8d %8.2f %6.2f %8.1f %6.1f %8.2f\n",
+                   d, w, ticks/n, mean/n, sd(mean,mean2,n),
+                   p99/n, sd(p99,p992,n), secs/n }' "$dir/out"
+  done
+done
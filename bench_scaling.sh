@@ -0,0 +1,44 @@
+#!/bin/sh
+#
+# bench_scaling.sh
+#
+#   Runs the elevator simulation over buildings of several heights with
+#   several numbers of cars, in virtual time, and reports for each run
+#   the ticks to finish, the mean and 99th percentile wait per trip, and
+#   the wall clock time.
+#
+#   Each height gets a workload generated by people.py from a fixed
+#   seed, and one sweep (elevators -w) runs every number of cars and
+#   every policy over it.
+#
+#   usage: bench_scaling.sh [-f floors,...] [-e elevators,...]
+#                           [-d policy,...] [-p people]
+#
+floors=11,50,100,150
+elevators=4,16,48
+policies=look
+people=2000
+while getopts "f:e:d:p:" opt; do
+  case $opt in
+    f) floors=$OPTARG ;;
+    e) elevators=$OPTARG ;;
+    d) policies=$OPTARG ;;
+    p) people=$OPTARG ;;
+    *) echo "usage: $0 [-f floors,...] [-e elevators,...]" \
+	    "[-d policy,...] [-p people]" >&2; exit 1 ;;
+  esac
+done
+
+dir=`mktemp -d` || exit 1
+trap 'rm -rf "$dir"' EXIT
+
+echo "$people people, 5 trips each"
+printf "%-12s %6s %9s %8s %8s %8s %8s\n" \
+  policy floors elevators ticks mean p99 seconds
+for f in `echo $floors | tr , ' '`; do
+  ${PYTHON:-python} people.py -s 1 -f $f -p $people -t 5 -d 100 \
+    > "$dir/f$f.eld" || exit 1
+  ./elevators -w -p -j 1 -f $f -e $elevators -d $policies "$dir/f$f.eld" |
+    awk -F, 'NR > 1 { printf "%-12s %6d %9d %8d %8.2f %8d %8.2f\n",
+                             $2, $3, $4, $7, $8, $9, $10 }'
+done
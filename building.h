@@ -7,11 +7,103 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <pthread.h>
 
 //
-//  The building has floors numbered 0, 1, 2, ... , MAXFLOOR
+//  The building has floors numbered 0, 1, 2, ... , floors-1, where
+//  floors is a setting of the Simulation.  People enter and leave on
+//  floor 1, so there are at least 2.
 //
-#define MAXFLOOR 10
+#define FLOORS 11                     // unless -f says otherwise
+
+class Workload;
+class Ticker;
+class Building;
+class PersonPool;
+class EventLog;
+class TraceWriter;
+struct Dispatch;
+struct Fiber;
+
+//
+// class Simulation
+//
+//     One run of the simulation.  Everything the run uses, from its
+//     clock to its statistics, belongs to its Simulation, and the
+//     Ticker, elevators and people each hold a reference to it.  Runs
+//     share nothing, so one process can have several going at once.
+//
+class Simulation {
+ public:
+  Simulation(const Workload *people, int elevators, const char *policy);
+  ~Simulation();
+  void run(void);                     // returns when everybody has left
+
+  //
+  // Settings, made before run
+  //
+  double speed;                       // seconds per tick, 0 for virtual
+  int floors;                         // floors 0 to floors-1
+  bool pooled;                        // run people on a PersonPool
+  int workers;                        // its threads, 0 for one per core
+  bool graphics;                      // graphics style output
+  bool display;                       // false for no output at all
+  TraceWriter *trace;                 // binary graphics output, or NULL
+
+  //
+  // Results, once run returns
+  //
+  int ticks(void) const;              // time everybody had left
+  int trips(void) const;
+  double average_wait(void) const;    // per trip
+  int percentile_wait(double pct) const;
+
+  void trip_done(int wait);           // a person finished a trip
+
+  //
+  // The parts of the simulation while it runs
+  //
+  Ticker *tick;                       // the clock
+  Building *building;                 // lets people in and out
+  PersonPool *pool;                   // runs the people, or NULL
+  EventLog *events;                   // takes the display, or NULL
+  Dispatch *dispatch;                 // the elevators
+  int next_unused_id;                 // for ElevatorMachinery ids
+
+ private:
+  const Workload *people;
+  int nelevators;
+  const char *policy;
+  int finish_time;
+  int total_wait;
+  int total_trips;
+  std::map<int,int> trip_waits;       // number of trips with each wait
+  pthread_mutex_t stats_lock;
+};
+
+//
+// class Condition
+//
+//     A condition variable that cooperates with the simulation clock.
+//     Elevators and people that need to block on each other should use
+//     a Condition instead of a pthread_cond_t.  A thread waiting on a
+//     Condition counts as idle, so virtual time (-s 0) can move on
+//     without it.  Only broadcast is provided.
+//
+class Condition {
+ public:
+  Condition(Simulation &sim);
+  void wait(pthread_mutex_t *m);      // m must be locked, as for pthreads
+  void broadcast();                   // caller must hold the waiters' mutex
+
+ private:
+  Simulation &sim;
+  pthread_cond_t cond;
+  int waiters;                        // blocked since last broadcast
+  int generation;                     // counts broadcasts
+  std::vector<Fiber *> fibers;        // PersonPool fibers among the waiters
+};
 
 //
 // class ElevatorMachinery
@@ -22,9 +114,10 @@
 //
 class ElevatorMachinery {
  public:
-  ElevatorMachinery();
+  ElevatorMachinery(Simulation &sim);
 
   int getid() const;                   // unique ID for this elevator
+  Simulation &simulation() const;      // the run this elevator is in
 
   //
   // Elevator display functions
@@ -51,8 +144,10 @@ class ElevatorMachinery {
   void open_door();
   void close_door();
 
+ protected:
+  Simulation &sim;
+
  private:
-  static int next_unused_id;
   int id;
   int floor;
   bool door_status;  // true if door is currently open
@@ -79,8 +174,8 @@ class ElevatorMachinery {
 //
 class Person {
  public:
-  Person();
-  Person(std::string);
+  Person(Simulation &sim, const Workload &w, int i);
+                                        // the i'th person to enter
   //  ~Person();
   //  Person(const Person&);
   //  Person& operator=(const Person&);
@@ -93,16 +188,26 @@ class Person {
   void message(const char *s, const int i) const;
                                         // variant also displays an int
 
+  Simulation &simulation() const;       // the run this person is in
+
  private:
+  Simulation &sim;
   int floor;
   std::string name;
   int entrytime;
-  std::vector<int> work_floors;
-  std::vector<int> work_times;
+  int trips;                            // number of work floors
+  const int *work_floors;               // kept by the Workload
+  const int *work_times;
+  int trip;                             // index of the next work floor
+  int trip_start;                       // time the current trip began
+  int my_wait_time;                     // total wait over finished trips
   void gmessage(const char *s) const;
   void warning(const char *s) const;
   double run(void);
+  bool wake(void);
+  int ride(void);
   friend void *person_runner(void *);
+  friend class PersonPool;
 };
 
 #endif
@@ -5,36 +5,253 @@
 #ifndef ELEVATORS_H
 #define ELEVATORS_H
 
+#include <vector>
+#include <deque>
+#include <stdlib.h>
+#include <pthread.h>
 #include "building.h"
 
+class Car;
+
+//
+//  Directions of travel.  A hall call is UP or DOWN; an elevator
+//  with nothing to do is IDLE.
+//
+enum Direction { DOWN, UP, IDLE };
+
+//
+//  struct Rider
+//    One person's trip, kept on their stack in take_elevator.
+//
+struct Rider {
+  const Person *who;
+  int destination;
+  Car *called;            // car given this rider's own call, if any
+  Car *car;               // set when the person boards
+  bool arrived;           // set when the car opens at destination
+};
+
+//
+//  struct Dispatch
+//    The elevators and floors of one Simulation, and their state.
+//
+//    The state is kept in tables, one entry per floor or per car, rather
+//    than in objects for each, so a policy weighing a call runs down a
+//    few contiguous arrays however tall the building.  A car's stops
+//    and calls are rows of floors entries, one car's row after another.
+//    The tables are sized once, before any elevator starts.
+//
+//    A floor's entries are guarded by its floor_lock, and a car's by
+//    the lock in its CarState.
+//
+struct Dispatch {
+  Dispatch(Simulation &sim, int ncars);
+  ~Dispatch();
+  void close(void);                     // stop each car once it is idle
+
+  //
+  // For the dispatch policies, with the car's lock held
+  //
+  int distance(int car, int floor) const;  // floors away, either way
+  bool stopping(int car, int floor) const; // a passenger is going to floor
+  bool marked(int car, int floor) const;   // any stop or call at floor
+  bool ahead(int car, int floor, Direction dir) const;
+                                           // any stop beyond floor?
+  int sweep(int car, int floor, Direction dir, bool scan) const;
+                                           // ticks to reach a call
+
+  int floors;                           // floors 0 to floors-1
+  std::vector<Car *> cars;              // every elevator, in order
+  void (*call)(Dispatch &d, Rider &r, int origin); // the policy's call
+
+  //
+  // Each floor.  Riders wait in a queue for each direction until an
+  // elevator going their way opens its door.
+  //
+  std::vector<pthread_mutex_t> floor_lock;
+  std::vector<std::vector<Rider *> > waiting[2]; // riders going DOWN, UP
+  std::vector<Car *> assigned[2];       // car answering each call, or NULL
+  std::deque<Condition> boarded[2];     // broadcast when riders board
+
+  //
+  // Each car.  What a car changes as it runs is kept together on a
+  // cache line of its own, so cars on different cores don't fight over
+  // one line.
+  //
+  struct alignas(64) CarState {
+    pthread_mutex_t lock;
+    int position;                       // floor, as seen by dispatch
+    Direction heading;
+    int load;                           // floors in stops and calls
+  };
+  std::vector<CarState> state;
+  std::vector<int> stops;               // passengers going to each floor
+  std::vector<char> calls[2];           // hall calls assigned, DOWN, UP
+};
+
+//
+//  class Car
+//    What every elevator has, whatever its dispatch policy.
+//
+//    Each car keeps the floors its passengers are going to and the
+//    hall calls it has been assigned in its row of the Dispatch tables,
+//    under its own lock.  The template Elevator below drives a Car with
+//    a dispatch policy.
+//
+class Car : public ElevatorMachinery {
+ public:
+  Car(Simulation &sim, Dispatch &d);
+  virtual ~Car() {}                     // Dispatch deletes the Elevators
+  virtual void run() = 0;               // returns once closed and idle
+  void close(void);
+
+  //
+  // display_passengers
+  //   should call display() for each Person on the elevator
+  //   and return the number of Person displayed
+  //
+  int display_passengers();
+
+  void assign(int floor, Direction dir); // answer a call
+  void cancel(int floor, Direction dir); // call answered by another car
+  void ride(Rider *r);                  // wait for r to arrive
+
+ protected:
+  void unload(int floor);
+
+  Dispatch &dispatch;
+  int index;                            // this car's entry in dispatch
+  pthread_mutex_t &lock;                // guards everything below
+  int &position;
+  Direction &heading;
+  int &pending;                         // load
+  int *stops;                           // this car's row, by floor
+  char *calls[2];                       // this car's rows, by floor
+  Condition work;                       // broadcast on a new call
+  std::deque<Condition> arrival;        // broadcast on opening at a floor
+  bool closed;                          // no more calls are coming
+  std::vector<Rider *> passengers;      // only changed by this car
+};
+
+//
+//  Dispatch policies
+//
+//    A policy is a class of static members, and is compiled into its
+//    Elevator, so choosing a stop or a car never makes a virtual call.
+//
+//    cost(d, car, floor, dir, destination)
+//        ticks for car, an index into d's tables, to answer a call,
+//        smallest wins.  Called with the car's lock held.
+//    scan
+//        true to run to the end of the building before turning round,
+//        false to turn as soon as nothing is left ahead (LOOK).
+//    destination
+//        true if each rider gives their destination and calls a car of
+//        their own, and boards only that car.  Otherwise the first
+//        rider in a queue makes one hall call for the lot.
+//
+struct Look {
+  static const bool scan = false;
+  static const bool destination = false;
+  static int cost(const Dispatch &d, int car, int floor, Direction dir, int)
+  {
+    return d.sweep(car,floor,dir,false) + 2*d.state[car].load;
+  }
+};
+
+struct Scan {
+  static const bool scan = true;
+  static const bool destination = false;
+  static int cost(const Dispatch &d, int car, int floor, Direction dir, int)
+  {
+    return d.sweep(car,floor,dir,true) + 2*d.state[car].load;
+  }
+};
+
+//
+//  NearestCar sends each call to the closest car, going whichever way.
+//
+struct NearestCar {
+  static const bool scan = false;
+  static const bool destination = false;
+  static int cost(const Dispatch &d, int car, int floor, Direction, int)
+  {
+    return d.distance(car,floor);
+  }
+};
+
+//
+//  Zoned splits the floors into one band for each car.  Calls within a
+//  band go to its car.  Everybody enters on floor 1, so calls there go
+//  to whichever car is cheapest.
+//
+struct Zoned {
+  static const bool scan = false;
+  static const bool destination = false;
+  static int cost(const Dispatch &d, int car, int floor, Direction dir, int)
+  {
+    int ticks = d.sweep(car,floor,dir,false) + 2*d.state[car].load;
+    if (floor == 1 || floor * (int)d.cars.size() / d.floors == car)
+      return ticks;
+    return ticks + 1000;
+  }
+};
+
+//
+//  Destination gives each rider a car as they call.  A car that already
+//  stops on the way costs less, so riders going to the same floor
+//  travel together.
+//
+struct Destination {
+  static const bool scan = false;
+  static const bool destination = true;
+  static int cost(const Dispatch &d, int car, int floor, Direction dir,
+		  int destination)
+  {
+    return d.sweep(car,floor,dir,false) + 2*d.state[car].load
+      + (d.stopping(car,destination) ? 0 : 2);
+  }
+};
+
 //
 //  One Elevator object will be created for each elevator
 //  in the simulation.
 //
-class Elevator : public ElevatorMachinery {
+//  The Elevator sweeps up and down, stopping wherever it has a
+//  passenger to drop or a call to answer.
+//
+template <class Policy>
+class Elevator : public Car {
  public:
-  Elevator();
+  Elevator(Simulation &sim, Dispatch &d);
 
   //
   // run
   //   will be called at the beginning of the simulation, to put the
   //   Elevator into operation.  run should pick up and deliver Persons,
   //   coordinating with other Elevators for efficient service.
-  //   run should never return.
-  //   
+  //   run should not return until the simulation is over.
+  //
   void run();
 
-  //
-  // display_passengers
-  //   should call display() for each Person on the elevator
-  //   and return the number of Person displayed
-  //
-  int display_passengers();
+  static void call(Dispatch &d, Rider &r, int origin);
 
  private:
-
+  bool plan(int here);                  // pick heading, true to stop
+  void serve(int floor, Direction dir); // stop, unload and board
+  void board(int floor, Direction dir);
+  static Elevator *choose(Dispatch &d, int floor, Direction dir,
+			 int destination);
 };
 
+//
+//  make_elevators
+//    Create n elevators for sim, run by the named dispatch policy.
+//    Returns NULL if there is no such policy.
+//
+Dispatch *make_elevators(Simulation &sim, const char *policy, int n);
+extern const char *policies[];          // policy names, NULL at the end
+
 //
 //  take_elevator
 //
@@ -44,4 +261,3 @@ class Elevator : public ElevatorMachinery {
 void take_elevator(const Person *who, int origin, int destination);
 
 #endif
-
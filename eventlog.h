@@ -0,0 +1,103 @@
+/*
+ * eventlog.h
+ *
+ *  Asynchronous display for the elevator simulation.
+ */
+#ifndef _EVENTLOG_H_
+#define _EVENTLOG_H_
+
+#include <atomic>
+#include <string>
+#include <pthread.h>
+
+class TraceWriter;
+
+//
+// class EventLog
+//
+//     Collects the display events of every thread and writes them out
+//     from a single writer thread.
+//
+//     An event is composed on the calling thread with begin, name, text
+//     and value, then post copies it into a ring of fixed-size records.
+//     The ring is a bounded multi-producer queue: a poster claims its
+//     records with one atomic add, so events come out in the order they
+//     were posted without anybody taking a lock.  Long events spill over
+//     into the following records.
+//
+//     The writer formats the events in text or graphics (-g) style and
+//     writes them in large batches.  Warnings go to stderr in text style,
+//     after whatever is waiting for stdout.  Given a TraceWriter, the
+//     writer records the graphics events in it instead.
+//
+class EventLog {
+ public:
+  enum Kind {
+    TICK,              // tick banner, id is the tick
+    TEXT,              // names displayed outside any other event
+    ELEVATOR,          // elevator message, names are the passengers
+    ELEVATOR_ACTION,   // elevator graphics command
+    ELEVATOR_WARNING,
+    PERSON,            // person message, name is the person
+    PERSON_ACTION,     // person graphics command
+    PERSON_WARNING
+  };
+
+  EventLog(bool graphics, TraceWriter *trace = NULL);
+  ~EventLog();               // after close
+  void start(void);          // start the writer thread
+  void close(void);          // write out everything posted, then stop
+
+  //
+  // Compose and post an event.  Each thread composes one at a time.
+  //
+  void begin(Kind kind, int id = 0, int floor = 0);
+  void name(const std::string &n);   // add a person's name
+  void text(const char *s);          // message or action
+  void value(int v);                 // number to follow the message
+  void post(void);
+
+  void tick(int t);                  // post a tick banner
+
+ private:
+  enum { RECORDS = 4096, PAYLOAD = 96 };
+  struct Record {
+    std::atomic<unsigned long> seq;  // position this record is ready for
+    unsigned char kind;
+    unsigned char has_value;
+    unsigned short names;            // names following the text
+    unsigned int parts;              // records used by this event
+    unsigned int length;             // payload bytes, over all parts
+    int id;
+    int floor;
+    int value;
+    char payload[PAYLOAD];
+  };
+
+  void run(void);                    // writer thread
+  bool ready(unsigned long pos) const;
+  void format(const Record &r, const char *payload);
+  void record(const Record &r, const char *payload);
+  void append_name(const char *n);
+  void append_int(int i);
+  void flush(int fd, std::string &buf);
+  void wait_for_posts(void);
+
+  bool graphics;
+  TraceWriter *trace;                // binary output, or NULL
+  Record *ring;
+  std::atomic<unsigned long> head;   // next position to claim
+  unsigned long tail;                // next position to write (writer only)
+  std::atomic<bool> closed;
+  std::atomic<bool> writer_asleep;
+  unsigned long end;                 // last position to write once closed
+  std::string out;                   // formatted stdout, not yet written
+  std::string err;                   // formatted stderr
+  std::string scratch;               // payload of a multi-part event
+  pthread_t writer;
+  pthread_mutex_t sleeplock;
+  pthread_cond_t posted;
+  friend void *log_writer(void *);
+};
+
+#endif
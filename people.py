@@ -9,13 +9,13 @@ Generate person records for the elevators simulation.
 """
 
 usage = """
-usage: people [-p people] [-t trips] [-d delaymax]
+usage: people [-p people] [-t trips] [-d delaymax] [-s seed] [-f floors]
 """
 
 import random
 import itertools
 
-MAXFLOOR = 10
+FLOORS = 11    # floors 0 to 10, as elevators has by default
 
 fnames = [
   "Phil",     "Pat",      "Peyton",  "Chamique",
@@ -71,15 +71,15 @@ class Person:
     ('Person'+str(x) for x in itertools.count())
     )
 
-  def __init__(self,trips,delaymax):
-    self.name = Person.fullnames.next()
+  def __init__(self,trips,delaymax,floors=FLOORS):
+    self.name = next(Person.fullnames)
 
     self.start = random.randint(1,delaymax)
     self.tasks = []
 
     floor = 1
     for i in range(trips):
-      floor = random.choice([x for x in range(MAXFLOOR+1) if x != floor])
+      floor = random.choice([x for x in range(floors) if x != floor])
       delay = random.randint(1,delaymax)
       self.tasks.append((floor,delay))
 
@@ -106,7 +106,13 @@ if __name__=='__main__':
                       help="Number of trips each person will make")
   parser.add_argument("-d","--delaymax",type=int,default=10,
                       help="Maximum delay on a given floor.")
+  parser.add_argument("-s","--seed",type=int,
+                      help="Seed the random numbers, for a repeatable run.")
+  parser.add_argument("-f","--floors",type=int,default=FLOORS,
+                      help="Number of floors, to match elevators -f.")
   args = parser.parse_args()
 
+  random.seed(args.seed)
+
   for i in range(args.people):
-    print Person(args.trips,args.delaymax)
+    print(Person(args.trips,args.delaymax,args.floors))
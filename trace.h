@@ -0,0 +1,120 @@
+/*
+ * trace.h
+ *
+ *  Binary traces of the elevator simulation's graphics (-g) stream.
+ */
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <string>
+#include <vector>
+#include <map>
+
+//
+//  Trace file layout
+//
+//    header   "ELTRACE\0", u32 version, u32 floors, u32 elevators
+//    records  each a type byte followed by its fields:
+//      'T'  varint tick delta                         !T
+//      'N'  varint length, name                       defines the next name id
+//      'E'  u16 elevator, u8 action, u16 floor,       !E
+//           u16 passengers, u32 name id each
+//      'P'  u32 name id, u8 action, u16 floor         !P
+//      'W'  varint length, text                       !W
+//      'F'  varint length, text                       !F
+//      'L'  varint length, text                       anything else, verbatim
+//    index    u32 tick, u64 offset of its 'T' record, for the first tick
+//             and then every 1024 ticks or 4K bytes, whichever is sooner
+//    names    varint length, name, for every name id
+//    footer   u64 index offset, u64 names offset, u32 index entries,
+//             u32 names, u32 last tick, "ELTRIDX\0"
+//
+//  Integers are little-endian.  Varints are unsigned LEB128.
+//  A trace cut short has no index or footer; TraceReader rebuilds them.
+//
+#define TRACE_VERSION 1
+#define TRACE_HEADER 20
+#define TRACE_FOOTER 36
+#define TRACE_INDEX_TICKS 1024
+#define TRACE_INDEX_BYTES 4096
+
+//
+// class TraceWriter
+//
+//     Encodes the graphics stream into a trace file.  Not thread safe;
+//     the EventLog's writer thread is the only user while the
+//     simulation runs.
+//
+class TraceWriter {
+ public:
+  TraceWriter(int fd);
+  void start(int floors, int elevators);   // !I, must come first
+  void tick(int t);
+  void elevator(int id, const char *action, int floor,
+		int npass, const char *names);   // names NUL separated
+  void person(const char *name, const char *action, int floor);
+  void warning(const char *s);
+  void finish(const char *s);
+  void text(const char *s, int len);     // lines other than ! commands
+  void flush(void);                      // write out what is encoded
+  void close(void);                      // add index and footer
+
+ private:
+  int intern(const char *name);
+  void string_record(char type, const char *s, int len);
+  void put8(int b);
+  void put16(int i);
+  void put32(unsigned int i);
+  void put64(unsigned long long i);
+  void varint(unsigned long long i);
+
+  int fd;
+  unsigned long long offset;             // file offset of buf
+  std::string buf;
+  int lasttick;
+  std::map<std::string,int> ids;
+  std::vector<std::string> names;
+  std::vector<std::pair<int,unsigned long long> > index;
+};
+
+//
+// class TraceReader
+//
+//     Memory-maps a trace file, finds any tick in it, and turns
+//     ranges of it back into graphics text.
+//
+class TraceReader {
+ public:
+  TraceReader(const char *path);         // throws a string on error
+  ~TraceReader();
+  int floors() const;
+  int elevators() const;
+  int first_tick() const;
+  int last_tick() const;
+
+  //
+  // replay
+  //   Write ticks first..last as graphics text, always starting with
+  //   the !I line.  If first is the start of the trace, what comes
+  //   before its first tick is included, and if last is the end, what
+  //   comes after.  With a delay, pause that many seconds at each tick.
+  //
+  void replay(int first, int last, double delay = 0);
+
+ private:
+  bool decode(unsigned long long &pos, int &t, std::string &out) const;
+  void rebuild(void);                    // scan records for index & names
+  unsigned int get16(unsigned long long pos) const;
+  unsigned int get32(unsigned long long pos) const;
+  unsigned long long get64(unsigned long long pos) const;
+  unsigned long long varint(unsigned long long &pos) const;
+
+  const unsigned char *map;
+  unsigned long long size;
+  unsigned long long records_end;        // where the index starts
+  int lasttick;
+  std::vector<std::pair<int,unsigned long long> > index;
+  std::vector<std::string> names;
+};
+
+#endif
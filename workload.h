@@ -0,0 +1,70 @@
+/*
+ * workload.h
+ *
+ *  The people in an elevator simulation, as read from its input.
+ */
+#ifndef _WORKLOAD_H_
+#define _WORKLOAD_H_
+
+#include <string>
+#include <vector>
+
+//
+// class Workload
+//
+//     Holds every person record from the input without making a Person
+//     of any of them.  The input is memory-mapped when it is a file, or
+//     read into one buffer when it is a pipe, and parsed in place.
+//     Names stay in the input buffer; everything else is kept in flat
+//     arrays, one per field, with all the work floors and times of all
+//     the people packed end to end.
+//
+//     Records are numbered in order of entry time.  If the input isn't
+//     in that order already, an index puts it in order, keeping people
+//     who enter together in input order.
+//
+//     Record format: name starttime floor1 worktime1 ... floorN worktimeN
+//     Lines that are blank or start with # are skipped.
+//
+//     A Workload doesn't know how tall the building is.  top gives the
+//     highest work floor, for the caller to check.
+//
+class Workload {
+ public:
+  Workload(int fd);                 // throws a string on a syntax error
+  ~Workload();
+
+  int size() const;                 // number of people
+  int top() const;                  // highest work floor, -1 if none
+  std::string name(int i) const;
+  int entrytime(int i) const;
+  int trips(int i) const;           // number of work floors
+  const int *floors(int i) const;   // work floors, trips(i) of them
+  const int *times(int i) const;    // work times, trips(i) of them
+
+ private:
+  void read(int fd);
+  void parse(void);
+  bool integer(const char *&p, const char *end, int &i) const;
+  int record(int i) const;          // record number to input position
+
+  const char *text;                 // the input
+  size_t length;
+  bool mapped;                      // text is mmapped, otherwise owned
+
+  // One element per person, in input order
+  std::vector<size_t> name_start;
+  std::vector<int> name_length;
+  std::vector<int> entry;
+  std::vector<int> first_trip;
+  std::vector<int> ntrips;
+
+  // One element per trip
+  std::vector<int> trip_floor;
+  std::vector<int> trip_time;
+
+  std::vector<int> order;           // entry order, empty if input is sorted
+  int highest;                      // highest work floor
+};
+
+#endif